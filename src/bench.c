@@ -0,0 +1,133 @@
+#include "rbtree.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// 비교 대상: key_t 배열 위의 최소 이진 힙
+typedef struct {
+    key_t *arr;
+    size_t size;
+} heap_t;
+
+static void heap_push(heap_t *h, const key_t key) {
+    size_t i = h->size++;
+
+    while (i > 0 && h->arr[(i - 1) / 2] > key) {
+        h->arr[i] = h->arr[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    h->arr[i] = key;
+}
+
+static key_t heap_pop(heap_t *h) {
+    key_t top = h->arr[0];
+    key_t last = h->arr[--h->size];
+    size_t i = 0;
+
+    while (2 * i + 1 < h->size) {
+        size_t c = 2 * i + 1;
+        if (c + 1 < h->size && h->arr[c + 1] < h->arr[c])
+            c++;
+        if (last <= h->arr[c])
+            break;
+        h->arr[i] = h->arr[c];
+        i = c;
+    }
+    h->arr[i] = last;
+    return top;
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// 스케줄러 run-queue 흉내: 가장 작은 vruntime을 꺼내 조금 늘린 뒤 다시 넣음
+static void bench_scheduler(const size_t n, const size_t ops) {
+    key_t popped, sum = 0;
+    double start;
+
+    srand(1);
+    rbtree *t = new_rbtree();
+    for (size_t i = 0; i < n; i++)
+        rbtree_insert(t, rand() % 1000000);
+
+    start = now_sec();
+    for (size_t i = 0; i < ops; i++) {
+        sum += rbtree_min(t)->key; // 매 tick마다 peek
+        rbtree_pop_min(t, &popped);
+        rbtree_insert(t, popped + rand() % 1000);
+    }
+    double treeSec = now_sec() - start;
+    delete_rbtree(t);
+
+    srand(1);
+    heap_t h = {calloc(n + 1, sizeof(key_t)), 0};
+    for (size_t i = 0; i < n; i++)
+        heap_push(&h, rand() % 1000000);
+
+    start = now_sec();
+    for (size_t i = 0; i < ops; i++) {
+        sum += h.arr[0];
+        popped = heap_pop(&h);
+        heap_push(&h, popped + rand() % 1000);
+    }
+    double heapSec = now_sec() - start;
+    free(h.arr);
+
+    printf("scheduler n=%zu ops=%zu: rbtree %.1f Mops/s, heap %.1f Mops/s (%d)\n", n, ops,
+           ops / treeSec / 1e6, ops / heapSec / 1e6, sum & 1);
+}
+
+// rbtree_clone과 key를 하나씩 다시 넣는 복사를 비교하고, 두 복사본의 탐색 속도도 측정
+static void bench_clone(const size_t n) {
+    key_t *arr = calloc(n, sizeof(key_t));
+    double start;
+
+    srand(2);
+    rbtree *t = new_rbtree();
+    for (size_t i = 0; i < n; i++)
+        rbtree_insert(t, rand());
+
+    // 다시 넣는 쪽도 원본을 읽어야 하므로 to_array 시간을 포함
+    start = now_sec();
+    rbtree_to_array(t, arr, n);
+    rbtree *copy = new_rbtree();
+    for (size_t i = 0; i < n; i++)
+        rbtree_insert(copy, arr[(i * 7919) % n]); // 정렬된 순서를 피해서 삽입
+    double insertSec = now_sec() - start;
+
+    start = now_sec();
+    rbtree *clone = rbtree_clone(t);
+    double cloneSec = now_sec() - start;
+
+    size_t found = 0;
+    start = now_sec();
+    for (size_t i = 0; i < n; i++)
+        found += rbtree_find(copy, arr[(i * 104729) % n]) != NULL;
+    double copyFindSec = now_sec() - start;
+
+    start = now_sec();
+    for (size_t i = 0; i < n; i++)
+        found += rbtree_find(clone, arr[(i * 104729) % n]) != NULL;
+    double cloneFindSec = now_sec() - start;
+
+    printf("clone n=%zu: re-insert %.1f ms, clone %.1f ms; find on re-inserted %.1f ns, on clone %.1f ns (%zu)\n", n,
+           insertSec * 1e3, cloneSec * 1e3, copyFindSec * 1e9 / n, cloneFindSec * 1e9 / n, found);
+
+    delete_rbtree(clone);
+    delete_rbtree(copy);
+    delete_rbtree(t);
+    free(arr);
+}
+
+int main(int argc, char *argv[]) {
+    size_t ops = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+
+    bench_scheduler(1000, ops);
+    bench_scheduler(100000, ops);
+    bench_clone(1000000);
+    return 0;
+}
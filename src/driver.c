@@ -1,5 +1,320 @@
 #include "rbtree.h"
 
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// 트레이스 형식: 한 줄에 연산 하나, '#'으로 시작하는 줄은 주석
+//   i <key>   insert        f <key>   find
+//   e <key>   find 후 erase  m         min
+//   M         max           a <n>     to_array (n개)
+// 파일을 한 줄씩 읽으므로 트레이스 크기와 상관없이 메모리 사용량은 일정함
+
+typedef enum { OP_INSERT, OP_FIND, OP_ERASE, OP_MIN, OP_MAX, OP_TO_ARRAY, OP_COUNT } op_t;
+
+static const char *opNames[OP_COUNT] = {"insert", "find", "erase", "min", "max", "to_array"};
+
+#define HIST_BUCKETS 32 // 2^i ns 이상 2^(i+1) ns 미만의 지연시간을 i번 버킷에 셈
+
+typedef struct {
+    uint64_t count;
+    uint64_t totalNs;
+    uint64_t hist[HIST_BUCKETS];
+} op_stat_t;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void record(op_stat_t *s, uint64_t ns) {
+    int b = 0;
+
+    while (b < HIST_BUCKETS - 1 && (ns >> (b + 1)) != 0)
+        b++;
+    s->count++;
+    s->totalNs += ns;
+    s->hist[b]++;
+}
+
+static int parse_op(const char *line, op_t *op, long long *arg) {
+    switch (line[0]) {
+    case 'i': *op = OP_INSERT; break;
+    case 'f': *op = OP_FIND; break;
+    case 'e': *op = OP_ERASE; break;
+    case 'm': *op = OP_MIN; break;
+    case 'M': *op = OP_MAX; break;
+    case 'a': *op = OP_TO_ARRAY; break;
+    default: return -1;
+    }
+
+    // min/max는 인자가 없으므로 뒤에 공백만 올 수 있음 ("max"가 min으로 재생되지 않도록)
+    if (*op == OP_MIN || *op == OP_MAX) {
+        const char *rest = line + 1;
+        while (isspace((unsigned char)*rest))
+            rest++;
+        return *rest == '\0' ? 0 : -1;
+    }
+
+    char *end;
+    errno = 0;
+    *arg = strtoll(line + 1, &end, 10);
+    if (end == line + 1 || errno == ERANGE)
+        return -1;
+    while (isspace((unsigned char)*end))
+        end++;
+    if (*end != '\0')
+        return -1;
+
+    // to_array 개수는 음수가 아니고 배열 크기 계산이 넘치지 않아야 하며, key는 key_t(int) 범위여야 함
+    if (*op == OP_TO_ARRAY)
+        return *arg >= 0 && (unsigned long long)*arg <= SIZE_MAX / sizeof(key_t) ? 0 : -1;
+    return *arg >= INT_MIN && *arg <= INT_MAX ? 0 : -1;
+}
+
+typedef struct {
+    rbtree *t; // NULL이면 읽기/파싱/시간 측정만 하고 라이브러리는 호출하지 않음 (보정용)
+    key_t *arr;
+    size_t arrSize;
+    size_t records;
+    op_stat_t stats[OP_COUNT];
+} replay_t;
+
+// 트레이스를 끝까지 재생 (지연시간은 라이브러리 호출 구간만 측정)
+static int replay(FILE *fp, const char *path, replay_t *r) {
+    size_t lineno = 0;
+    char line[128];
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        op_t op;
+        long long arg = 0;
+
+        lineno++;
+
+        // 버퍼보다 긴 줄은 나머지를 버리고 한 줄짜리 오류로 처리
+        if (strchr(line, '\n') == NULL && !feof(fp)) {
+            int c;
+            while ((c = fgetc(fp)) != EOF && c != '\n')
+                ;
+            fprintf(stderr, "%s:%zu: record too long\n", path, lineno);
+            continue;
+        }
+
+        if (line[0] == '#' || line[0] == '\n')
+            continue;
+        if (parse_op(line, &op, &arg) != 0) {
+            fprintf(stderr, "%s:%zu: bad record\n", path, lineno);
+            continue;
+        }
+        if (op == OP_TO_ARRAY && (size_t)arg > r->arrSize) {
+            key_t *grown = realloc(r->arr, (size_t)arg * sizeof(key_t));
+            if (grown == NULL) {
+                fprintf(stderr, "%s:%zu: cannot allocate %lld keys for to_array\n", path, lineno, arg);
+                return 1;
+            }
+            r->arr = grown;
+            r->arrSize = arg;
+        }
+
+        r->records++;
+        uint64_t start = now_ns();
+        if (r->t != NULL) {
+            switch (op) {
+            case OP_INSERT:
+                rbtree_insert(r->t, arg);
+                break;
+            case OP_FIND:
+                rbtree_find(r->t, arg);
+                break;
+            case OP_ERASE: {
+                node_t *p = rbtree_find(r->t, arg);
+                if (p != NULL)
+                    rbtree_erase(r->t, p);
+                break;
+            }
+            case OP_MIN:
+                rbtree_min(r->t);
+                break;
+            case OP_MAX:
+                rbtree_max(r->t);
+                break;
+            case OP_TO_ARRAY:
+                rbtree_to_array(r->t, r->arr, arg);
+                break;
+            default:
+                break;
+            }
+        }
+        record(&r->stats[op], now_ns() - start);
+    }
+    return 0;
+}
+
+#ifdef __linux__
+// perf_event_open으로 하드웨어 카운터를 그룹으로 묶어 재생 전체에서 한 번만 켜고 끔
+// (레코드마다 ioctl을 부르면 시스템 콜 비용이 지연시간과 카운터를 덮어버림)
+// 트레이스 읽기/파싱/시간 측정 비용은 같은 루프를 라이브러리 호출 없이 돌려 레코드당 값으로 보정
+static const struct {
+    const char *name;
+    uint64_t config;
+} perfEvents[] = {
+    {"cycles", PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_COUNT_HW_INSTRUCTIONS},
+    {"cache-misses", PERF_COUNT_HW_CACHE_MISSES},
+    {"branch-misses", PERF_COUNT_HW_BRANCH_MISSES},
+};
+#define PERF_NEVENTS (sizeof(perfEvents) / sizeof(perfEvents[0]))
+#define CALIBRATION_RECORDS 100000
+
+static int perf_open(int *fds) {
+    for (size_t i = 0; i < PERF_NEVENTS; i++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = perfEvents[i].config;
+        attr.disabled = i == 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds[0], 0);
+        if (fds[i] < 0) {
+            while (i-- > 0)
+                close(fds[i]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void perf_start(const int *fds) {
+    ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+static void perf_stop(const int *fds, uint64_t *values) {
+    ioctl(fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    for (size_t i = 0; i < PERF_NEVENTS; i++) {
+        values[i] = 0;
+        if (read(fds[i], &values[i], sizeof(values[i])) != sizeof(values[i]))
+            values[i] = 0;
+    }
+}
+
+// 라이브러리를 부르지 않는 재생으로 레코드 하나당 읽기/파싱/시간 측정 비용을 잼
+static void perf_calibrate(const int *fds, double *perRecord) {
+    size_t size = CALIBRATION_RECORDS * 4;
+    char *buf = malloc(size);
+    uint64_t values[PERF_NEVENTS];
+    replay_t dry = {0};
+
+    for (size_t i = 0; i < CALIBRATION_RECORDS; i++)
+        memcpy(buf + i * 4, "f 0\n", 4);
+
+    FILE *fp = fmemopen(buf, size, "r");
+    perf_start(fds);
+    replay(fp, "calibration", &dry);
+    perf_stop(fds, values);
+    fclose(fp);
+    free(buf);
+
+    for (size_t i = 0; i < PERF_NEVENTS; i++)
+        perRecord[i] = (double)values[i] / CALIBRATION_RECORDS;
+}
+
+static void perf_report(const uint64_t *values, const double *perRecord, size_t records) {
+    printf("%-14s %16s %16s %16s\n", "counter", "total", "reader", "library");
+    for (size_t i = 0; i < PERF_NEVENTS; i++) {
+        double reader = perRecord[i] * records;
+        double library = values[i] > reader ? values[i] - reader : 0;
+        printf("%-14s %16llu %16.0f %16.0f\n", perfEvents[i].name, (unsigned long long)values[i], reader, library);
+    }
+}
+#endif
+
+static void report(const op_stat_t *stats) {
+    for (int op = 0; op < OP_COUNT; op++) {
+        const op_stat_t *s = &stats[op];
+        if (s->count == 0)
+            continue;
+
+        printf("%-8s %12llu ops  %8.1f ns/op  %8.2f Mops/s\n", opNames[op], (unsigned long long)s->count,
+               (double)s->totalNs / s->count, s->count * 1e3 / s->totalNs);
+        for (int b = 0; b < HIST_BUCKETS; b++) {
+            if (s->hist[b] != 0)
+                printf("    <%10llu ns %12llu\n", 2ull << b, (unsigned long long)s->hist[b]);
+        }
+    }
+}
+
 int main(int argc, char *argv[]) {
+    const char *path = NULL;
+    int usePerf = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-p") == 0)
+            usePerf = 1;
+        else
+            path = argv[i];
+    }
+    if (path == NULL) {
+        fprintf(stderr, "usage: %s [-p] <trace|->\n", argv[0]);
+        return 1;
+    }
+
+    FILE *fp = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (fp == NULL) {
+        perror(path);
+        return 1;
+    }
+
+    replay_t r = {0};
+    int status;
+
+    r.t = new_rbtree();
+
+#ifdef __linux__
+    int perfFds[PERF_NEVENTS];
+    uint64_t values[PERF_NEVENTS];
+    double perRecord[PERF_NEVENTS];
+
+    if (usePerf && perf_open(perfFds) != 0) {
+        perror("perf_event_open");
+        usePerf = 0;
+    }
+    if (usePerf) {
+        perf_calibrate(perfFds, perRecord);
+        perf_start(perfFds);
+    }
+    status = replay(fp, path, &r);
+    if (usePerf) {
+        perf_stop(perfFds, values);
+        perf_report(values, perRecord, r.records);
+        for (size_t i = 0; i < PERF_NEVENTS; i++)
+            close(perfFds[i]);
+    }
+#else
+    if (usePerf)
+        fprintf(stderr, "perf counters are only supported on Linux\n");
+    status = replay(fp, path, &r);
+#endif
+    report(r.stats);
 
-}
\ No newline at end of file
+    if (fp != stdin)
+        fclose(fp);
+    free(r.arr);
+    delete_rbtree(r.t);
+    return status;
+}
@@ -1,7 +1,10 @@
 #include "rbtree.h"
 
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 // 트리 생성
 rbtree *new_rbtree(void) {
@@ -9,12 +12,34 @@ rbtree *new_rbtree(void) {
     node_t *nil = (node_t *)calloc(1, sizeof(node_t));
 
     nil->color = RBTREE_BLACK;
+#ifdef RBTREE_AUGMENT
+    nil->aug = RBTREE_AUG_IDENTITY;
+#endif
     t->nil = nil;
     t->root = nil;
+    t->leftmost = nil;
+    t->rightmost = nil;
 
     return t;
 }
 
+#ifdef RBTREE_AUGMENT
+// 자식들의 집계값으로 x의 집계값을 다시 계산 (nil의 집계값은 항등원으로 고정)
+static void augment_update(rbtree *t, node_t *x) {
+    x->aug = RBTREE_AUG_COMBINE(RBTREE_AUG_COMBINE(x->left->aug, RBTREE_AUG_VALUE(x)), x->right->aug);
+}
+
+// x부터 루트까지 올라가며 집계값 갱신
+void rbtree_augment_propagate(rbtree *t, node_t *x) {
+    while (x != t->nil) {
+        augment_update(t, x);
+        x = x->parent;
+    }
+}
+#else
+#define augment_update(t, x) ((void)0)
+#endif
+
 // 현재 노드를 기준으로 왼쪽 회전
 void left_rotation(rbtree *t, node_t *x) {
     node_t *y = x->right;
@@ -35,6 +60,10 @@ void left_rotation(rbtree *t, node_t *x) {
 
     y->left = x;
     x->parent = y;
+
+    // 회전으로 서브트리가 바뀐 것은 x와 y뿐 (x가 y의 자식이 되었으므로 x 먼저)
+    augment_update(t, x);
+    augment_update(t, y);
 }
 
 void right_rotation(rbtree *t, node_t *x) {
@@ -56,26 +85,276 @@ void right_rotation(rbtree *t, node_t *x) {
 
     y->right = x;
     x->parent = y;
+
+    augment_update(t, x);
+    augment_update(t, y);
 }
 
-void free_node(rbtree *t, node_t *x) {
-    // 후위 순회 방식으로 RB Tree 내의 노드 메모리 반환
-    if (x->left != t->nil) // 왼쪽으로 파고들기
-        free_node(t, x->left);
-    if (x->right != t->nil) // 오른쪽으로 파고들기
-        free_node(t, x->right);
-    free(x);  // 해당노드 메모리 free
-    x = NULL; // free 후에는 사용한 변수는 NULL로 초기화(안전함)
+// clone의 pool 안에 있는 노드는 free하지 않고 재사용 목록에 넣음 (pool은 트리를 해제할 때 통째로 반환)
+static void free_node(rbtree *t, node_t *x) {
+    if ((uintptr_t)x - (uintptr_t)t->pool < t->poolSize * sizeof(node_t)) {
+        x->parent = t->poolFree;
+        t->poolFree = x;
+        return;
+    }
+    free(x);
+}
+
+// pool에 빈 자리가 있으면 먼저 쓰고, 없으면 새로 할당
+static node_t *alloc_node(rbtree *t) {
+    node_t *x = t->poolFree;
+
+    if (x == NULL)
+        return (node_t *)calloc(1, sizeof(node_t));
+
+    t->poolFree = x->parent;
+    memset(x, 0, sizeof(node_t));
+    return x;
 }
 
 void delete_rbtree(rbtree *t) {
-    // t의 루트가 nil이 아닐 떄 노드 free
+    // budget 제한 없이 한 번에 반복 해제 (재귀를 쓰지 않으므로 트리 모양과 상관없이 스택 사용량 일정)
+    rbtree_destroy_step(t, (size_t)-1);
+}
+
+rbtree *rbtree_detach(rbtree *t) {
+    rbtree *old = (rbtree *)malloc(sizeof(rbtree));
+    node_t *nil = (node_t *)calloc(1, sizeof(node_t));
+
+    // 기존 노드와 nil은 통째로 old로 넘기고 t에는 새 nil로 빈 트리를 만듦
+    *old = *t;
+
+    nil->color = RBTREE_BLACK;
+#ifdef RBTREE_AUGMENT
+    nil->aug = RBTREE_AUG_IDENTITY;
+#endif
+    t->nil = nil;
+    t->root = nil;
+    t->leftmost = nil;
+    t->rightmost = nil;
+    t->pool = NULL;
+    t->poolSize = 0;
+    t->poolFree = NULL;
+
+    return old;
+}
+
+int rbtree_destroy_step(rbtree *t, size_t budget) {
+    node_t *x = t->root;
+
+    // 후위 순회를 parent 포인터로 진행: 잎까지 내려가서 해제하고 부모에서 그 자식을 nil로 끊음
+    // 호출마다 루트에서 다시 내려가므로 호출당 추가 비용은 O(log n)
+    while (budget > 0 && x != t->nil) {
+        if (x->left != t->nil) {
+            x = x->left;
+        } else if (x->right != t->nil) {
+            x = x->right;
+        } else {
+            node_t *p = x->parent;
+
+            if (p == t->nil)
+                t->root = t->nil;
+            else if (x == p->left)
+                p->left = t->nil;
+            else
+                p->right = t->nil;
+
+            free_node(t, x);
+            budget--;
+            x = p;
+        }
+    }
+
     if (t->root != t->nil)
-        free_node(t, t->root);
-    // nil노드 free
+        return 1;
+
+    // 노드를 모두 해제했으면 pool, nil과 tree 구조체까지 반환
+    free(t->pool);
     free(t->nil);
     free(t);
-    t=NULL;
+    return 0;
+}
+
+// RB tree의 높이는 2 * log2(n + 1) 이하이므로 size_t로 셀 수 있는 어떤 트리도 이 깊이를 넘지 않음
+#define RBTREE_MAX_HEIGHT (2 * 8 * sizeof(size_t))
+
+// x의 복사본을 y로 초기화 (자식은 아직 없음)
+static void clone_node(rbtree *c, node_t *y, const node_t *x, node_t *parent) {
+    y->color = x->color;
+    y->key = x->key;
+#ifdef RBTREE_AUGMENT
+    y->aug = x->aug;
+#endif
+    y->parent = parent;
+    y->left = c->nil;
+    y->right = c->nil;
+}
+
+rbtree *rbtree_clone(const rbtree *t) {
+    rbtree *c = new_rbtree();
+    // 전위 순회용 고정 크기 스택: 원본 노드와 복사본에서 연결될 자리(부모의 left/right 또는 root)
+    struct {
+        node_t *x;
+        node_t *parent;
+        node_t **link;
+    } stack[RBTREE_MAX_HEIGHT + 1];
+    size_t top = 0;
+    size_t n = 0;
+
+    if (t->root == t->nil)
+        return c;
+
+    // 1단계: 노드 수를 세서 복사본 노드를 한 번에 할당
+    stack[top++].x = t->root;
+    while (top > 0) {
+        node_t *x = stack[--top].x;
+        n++;
+        if (x->right != t->nil)
+            stack[top++].x = x->right;
+        if (x->left != t->nil)
+            stack[top++].x = x->left;
+    }
+
+    c->pool = (node_t *)malloc(n * sizeof(node_t));
+    c->poolSize = n;
+
+    // 2단계: 같은 순서로 다시 돌며 pool의 다음 칸에 복사하므로 복사본은 전위 순서로 연속 배치됨
+    // (부모 바로 뒤에 왼쪽 자식이 오므로 탐색 경로가 인접한 캐시 라인에 모임)
+    size_t i = 0;
+    stack[top].x = t->root;
+    stack[top].parent = c->nil;
+    stack[top++].link = &c->root;
+    while (top > 0) {
+        top--;
+        node_t *x = stack[top].x;
+        node_t *y = &c->pool[i++];
+
+        clone_node(c, y, x, stack[top].parent);
+        *stack[top].link = y;
+
+        if (x == t->leftmost)
+            c->leftmost = y;
+        if (x == t->rightmost)
+            c->rightmost = y;
+
+        if (x->right != t->nil) {
+            stack[top].x = x->right;
+            stack[top].parent = y;
+            stack[top++].link = &y->right;
+        }
+        if (x->left != t->nil) {
+            stack[top].x = x->left;
+            stack[top].parent = y;
+            stack[top++].link = &y->left;
+        }
+    }
+
+    return c;
+}
+
+// 백그라운드 해제 대기열 (모든 트리가 reclaimer 스레드 하나를 공유)
+typedef struct reclaim_item {
+    rbtree *t;
+    struct reclaim_item *next;
+} reclaim_item;
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t wake;   // reclaimer 스레드를 깨움
+    pthread_cond_t joined; // join이 끝났음을 기다리던 다른 join 호출에 알림
+    reclaim_item *head, *tail;
+    int running, stopping;
+    int joining;      // 한 호출이 pthread_join 중이면 1 (같은 스레드를 두 번 join하지 않도록)
+    size_t reclaimed; // 마지막 join 이후 해제한 트리 수
+    pthread_t tid;
+} reclaimer = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER};
+
+static void *reclaimer_main(void *arg) {
+    pthread_mutex_lock(&reclaimer.lock);
+    for (;;) {
+        while (reclaimer.head == NULL && !reclaimer.stopping)
+            pthread_cond_wait(&reclaimer.wake, &reclaimer.lock);
+        // 종료 요청을 받아도 대기열을 다 비운 뒤에 끝냄
+        if (reclaimer.head == NULL)
+            break;
+
+        reclaim_item *item = reclaimer.head;
+        reclaimer.head = item->next;
+        if (reclaimer.head == NULL)
+            reclaimer.tail = NULL;
+
+        // 해제하는 동안에는 락을 풀어서 rbtree_destroy_async가 막히지 않게 함
+        pthread_mutex_unlock(&reclaimer.lock);
+        delete_rbtree(item->t);
+        free(item);
+        pthread_mutex_lock(&reclaimer.lock);
+        reclaimer.reclaimed++;
+    }
+    pthread_mutex_unlock(&reclaimer.lock);
+    return NULL;
+}
+
+int rbtree_destroy_async(rbtree *t) {
+    reclaim_item *item = (reclaim_item *)malloc(sizeof(reclaim_item));
+
+    pthread_mutex_lock(&reclaimer.lock);
+    // 첫 호출에서 reclaimer를 띄우고, 띄울 수 없으면 호출한 쪽에서 바로 해제
+    if (item == NULL || (!reclaimer.running && pthread_create(&reclaimer.tid, NULL, reclaimer_main, NULL) != 0)) {
+        pthread_mutex_unlock(&reclaimer.lock);
+        free(item);
+        delete_rbtree(t);
+        return -1;
+    }
+    reclaimer.running = 1;
+
+    item->t = t;
+    item->next = NULL;
+    if (reclaimer.tail == NULL)
+        reclaimer.head = item;
+    else
+        reclaimer.tail->next = item;
+    reclaimer.tail = item;
+
+    pthread_cond_signal(&reclaimer.wake);
+    pthread_mutex_unlock(&reclaimer.lock);
+    return 0;
+}
+
+size_t rbtree_reclaim_join(void) {
+    pthread_mutex_lock(&reclaimer.lock);
+    while (reclaimer.joining)
+        pthread_cond_wait(&reclaimer.joined, &reclaimer.lock);
+
+    if (reclaimer.running) {
+        reclaimer.joining = 1;
+        reclaimer.stopping = 1;
+        pthread_cond_signal(&reclaimer.wake);
+        pthread_mutex_unlock(&reclaimer.lock);
+
+        pthread_join(reclaimer.tid, NULL);
+
+        pthread_mutex_lock(&reclaimer.lock);
+        reclaimer.running = 0;
+        reclaimer.stopping = 0;
+        reclaimer.joining = 0;
+        pthread_cond_broadcast(&reclaimer.joined);
+    }
+
+    // 스레드가 끝난 직후 들어온 트리는 대기열에서 떼어낸 뒤 락 없이 여기서 해제
+    reclaim_item *item = reclaimer.head;
+    reclaimer.head = reclaimer.tail = NULL;
+    size_t reclaimed = reclaimer.reclaimed;
+    reclaimer.reclaimed = 0;
+    pthread_mutex_unlock(&reclaimer.lock);
+
+    while (item != NULL) {
+        reclaim_item *next = item->next;
+        delete_rbtree(item->t);
+        free(item);
+        reclaimed++;
+        item = next;
+    }
+    return reclaimed;
 }
 
 void rbtree_insert_fixup(rbtree *t, node_t *z) {
@@ -135,20 +414,30 @@ void rbtree_insert_fixup(rbtree *t, node_t *z) {
 node_t *rbtree_insert(rbtree *t, const key_t key) {
     node_t *y = t->nil;
     node_t *x = t->root;
-    node_t *z = (node_t *)calloc(1, sizeof(node_t));
+    node_t *z = alloc_node(t);
+    int isLeftmost = 1;  // 내려가는 동안 왼쪽으로만 갔으면 새 최소 노드
+    int isRightmost = 1; // 오른쪽으로만 갔으면 새 최대 노드
 
     z->key = key;
 
     while (x != t->nil) {
         y = x;
-        if (z->key < x->key)
+        if (z->key < x->key) {
             x = x->left;
-        else
+            isRightmost = 0;
+        } else {
             x = x->right;
+            isLeftmost = 0;
+        }
     }
 
     z->parent = y;
 
+    if (isLeftmost)
+        t->leftmost = z;
+    if (isRightmost)
+        t->rightmost = z;
+
     if (y == t->nil) {
         t->root = z;
     } else if (z->key < y->key) {
@@ -161,6 +450,9 @@ node_t *rbtree_insert(rbtree *t, const key_t key) {
     z->right = t->nil;
     z->color = RBTREE_RED;
 
+    // 새 노드부터 루트까지의 경로만 집계값이 바뀜
+    rbtree_augment_propagate(t, z);
+
     rbtree_insert_fixup(t, z);
 
     return z;
@@ -188,29 +480,18 @@ node_t *rbtree_find(const rbtree *t, const key_t key) {
 
 node_t *rbtree_min(const rbtree *t) {
 
-    if (t->root == t->nil) {
+    if (t->leftmost == t->nil) {
         return NULL;
     }
-    node_t *curr = t->root;
-
-    while (curr->left != t->nil) {
-        curr = curr->left;
-    }
-    return curr;
+    return t->leftmost;
 }
 
 node_t *rbtree_max(const rbtree *t) {
 
-    if (t->root == t->nil) {
+    if (t->rightmost == t->nil) {
         return NULL;
     }
-
-    node_t *curr = t->root;
-
-    while (curr->right != t->nil) {
-        curr = curr->right;
-    }
-    return curr;
+    return t->rightmost;
 }
 
 void rbtree_transplant(rbtree *t, node_t *u, node_t *v) {
@@ -307,6 +588,25 @@ int rbtree_erase(rbtree *t, node_t *z) {
     node_t *y = z;
     color_t yOriginalColor = y->color;
 
+    // 최소/최대 노드를 지우는 경우 구조가 바뀌기 전에 다음 후보를 찾아둠
+    // 최소 노드는 왼쪽 자식이 없으므로 후속자는 오른쪽 서브트리의 최소 노드이거나 부모
+    if (z == t->leftmost) {
+        if (z->right != t->nil) {
+            t->leftmost = z->right;
+            while (t->leftmost->left != t->nil)
+                t->leftmost = t->leftmost->left;
+        } else
+            t->leftmost = z->parent;
+    }
+    if (z == t->rightmost) {
+        if (z->left != t->nil) {
+            t->rightmost = z->left;
+            while (t->rightmost->right != t->nil)
+                t->rightmost = t->rightmost->right;
+        } else
+            t->rightmost = z->parent;
+    }
+
     if (z->left == t->nil) {
         x = z->right;
         rbtree_transplant(t, z, z->right);
@@ -335,15 +635,41 @@ int rbtree_erase(rbtree *t, node_t *z) {
         y->color = z->color;
     }
 
+    // 구조가 바뀐 가장 낮은 지점은 항상 x의 부모 (x가 nil이어도 transplant가 parent를 설정함)
+    rbtree_augment_propagate(t, x->parent);
+
     if (yOriginalColor == RBTREE_BLACK) {
         rbtree_delete_fixup(t, x);
     }
 
-    free(z);
+    free_node(t, z);
     z=NULL;
     return 0;
 }
 
+// 캐시된 최소/최대 노드를 탐색 없이 바로 삭제 (한쪽 자식이 nil이므로 erase에서 후속자 탐색도 없음)
+int rbtree_pop_min(rbtree *t, key_t *key) {
+    node_t *z = t->leftmost;
+
+    if (z == t->nil)
+        return -1;
+
+    if (key != NULL)
+        *key = z->key;
+    return rbtree_erase(t, z);
+}
+
+int rbtree_pop_max(rbtree *t, key_t *key) {
+    node_t *z = t->rightmost;
+
+    if (z == t->nil)
+        return -1;
+
+    if (key != NULL)
+        *key = z->key;
+    return rbtree_erase(t, z);
+}
+
 void subtree_to_array(const rbtree *t, node_t *curr, key_t *arr, size_t n, size_t *index) {
     if (curr == t->nil)
         return;
@@ -363,4 +689,54 @@ int rbtree_to_array(const rbtree *t, key_t *arr, const size_t n) {
     size_t index = 0;
     subtree_to_array(t, t->root, arr, n, &index);
     return 0;
-}
\ No newline at end of file
+}
+#ifdef RBTREE_AUGMENT
+// x의 서브트리에서 key >= lo인 노드들의 집계값
+static aug_t aggregate_from(const rbtree *t, node_t *x, const key_t lo) {
+    aug_t res = RBTREE_AUG_IDENTITY;
+
+    while (x != t->nil) {
+        if (x->key >= lo) {
+            // x와 오른쪽 서브트리 전체가 포함되고, 왼쪽에서 찾은 값은 앞에 붙음
+            res = RBTREE_AUG_COMBINE(RBTREE_AUG_COMBINE(RBTREE_AUG_VALUE(x), x->right->aug), res);
+            x = x->left;
+        } else
+            x = x->right;
+    }
+    return res;
+}
+
+// x의 서브트리에서 key < hi인 노드들의 집계값
+static aug_t aggregate_until(const rbtree *t, node_t *x, const key_t hi) {
+    aug_t res = RBTREE_AUG_IDENTITY;
+
+    while (x != t->nil) {
+        if (x->key < hi) {
+            res = RBTREE_AUG_COMBINE(res, RBTREE_AUG_COMBINE(x->left->aug, RBTREE_AUG_VALUE(x)));
+            x = x->right;
+        } else
+            x = x->left;
+    }
+    return res;
+}
+
+aug_t rbtree_range_aggregate(const rbtree *t, const key_t lo, const key_t hi) {
+    node_t *x = t->root;
+
+    // [lo, hi)에 들어가는 가장 위의 노드(분기점)를 찾음
+    while (x != t->nil) {
+        if (x->key < lo)
+            x = x->right;
+        else if (x->key >= hi)
+            x = x->left;
+        else
+            break;
+    }
+
+    if (x == t->nil)
+        return RBTREE_AUG_IDENTITY;
+
+    return RBTREE_AUG_COMBINE(RBTREE_AUG_COMBINE(aggregate_from(t, x->left, lo), RBTREE_AUG_VALUE(x)),
+                              aggregate_until(t, x->right, hi));
+}
+#endif
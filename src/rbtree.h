@@ -12,12 +12,39 @@ typedef enum
 
 typedef int key_t;
 
+// RBTREE_AUGMENT을 정의하고 빌드하면 각 노드가 서브트리 집계값(aug)을 함께 유지
+// 기본값은 key의 합이며, 아래 매크로를 -D로 재정의하면 min/max/개수 등으로 바꿀 수 있음
+// (라이브러리와 사용하는 쪽 모두 같은 매크로로 빌드해야 함)
+//   RBTREE_AUG_T              : 집계값 타입
+//   RBTREE_AUG_IDENTITY       : 항등원 (nil 노드의 집계값)
+//   RBTREE_AUG_VALUE(n)       : 노드 하나의 값
+//   RBTREE_AUG_COMBINE(a, b)  : 결합 함수 (결합법칙을 만족해야 하며 a가 b보다 key 순서상 앞)
+#ifdef RBTREE_AUGMENT
+#ifndef RBTREE_AUG_T
+#define RBTREE_AUG_T long long
+#endif
+#ifndef RBTREE_AUG_IDENTITY
+#define RBTREE_AUG_IDENTITY 0
+#endif
+#ifndef RBTREE_AUG_VALUE
+#define RBTREE_AUG_VALUE(n) ((RBTREE_AUG_T)(n)->key)
+#endif
+#ifndef RBTREE_AUG_COMBINE
+#define RBTREE_AUG_COMBINE(a, b) ((a) + (b))
+#endif
+
+typedef RBTREE_AUG_T aug_t;
+#endif
+
 // tree의 각 노드를 표현하는 구조체
 typedef struct node_t
 {
   color_t color;
   key_t key;
   struct node_t *parent, *left, *right;
+#ifdef RBTREE_AUGMENT
+  aug_t aug; // 이 노드를 루트로 하는 서브트리의 집계값
+#endif
 } node_t;
 
 // tree 자체를 나타내는 구조체
@@ -25,17 +52,42 @@ typedef struct
 {
   node_t *root;
   node_t *nil; // for sentinel
+  node_t *leftmost, *rightmost; // 최소/최대 노드 캐시 (빈 트리면 nil), rbtree_min/max를 O(1)로 만듦
+  node_t *pool;                 // rbtree_clone이 한 번에 할당한 노드 배열 (이 안의 노드는 개별 free하지 않음)
+  size_t poolSize;
+  node_t *poolFree;             // pool에서 삭제된 노드 목록 (parent로 연결), rbtree_insert가 먼저 재사용
 } rbtree;
 
 rbtree *new_rbtree(void);     // 새 트리를 생성하는 함수
 void delete_rbtree(rbtree *); // 트리를 순회하면서 각 노드의 메모리를 반환하는 함수
 
+rbtree *rbtree_detach(rbtree *);               // 트리 내용을 O(1)에 떼어내 반환하고 원래 트리는 빈 트리로 만드는 함수
+int rbtree_destroy_step(rbtree *, size_t);     // 노드를 최대 budget개만 해제하는 함수 (남았으면 1, 트리까지 모두 반환했으면 0)
+int rbtree_destroy_async(rbtree *);            // 공용 reclaimer 스레드의 대기열에 넣어 해제하는 함수 (스레드를 띄울 수 없으면 바로 해제하고 -1)
+size_t rbtree_reclaim_join(void);              // 대기열의 트리를 모두 해제할 때까지 기다리고 reclaimer를 종료하는 함수 (해제한 트리 수 반환, 동시 호출 가능)
+rbtree *rbtree_clone(const rbtree *);          // 모양과 색을 그대로 복사한 트리를 반환하는 함수 (노드는 전위 순서로 연속 배치)
+                                               // 복사본에서 삭제한 노드 자리는 이후 삽입에 재사용되고 pool은 트리를 해제할 때 반환됨
+
 node_t *rbtree_insert(rbtree *, const key_t);     // 노드를 삽입하고 불균형을 복구하는 함수
 node_t *rbtree_find(const rbtree *, const key_t); // key에 해당하는 노드를 반환하는 함수
 node_t *rbtree_min(const rbtree *);               // key가 최소값에 해당하는 노드를 반환하는 함수
 node_t *rbtree_max(const rbtree *);               // key가 최대값에 해당하는 노드를 반환하는 함수
 int rbtree_erase(rbtree *, node_t *);             // 노드를 삭제하는 함수
+int rbtree_pop_min(rbtree *, key_t *);            // 최소 노드를 삭제하고 key를 담는 함수 (빈 트리면 -1)
+int rbtree_pop_max(rbtree *, key_t *);            // 최대 노드를 삭제하고 key를 담는 함수 (빈 트리면 -1)
 
 int rbtree_to_array(const rbtree *, key_t *, const size_t); //'t'를 inorder로 'n'번 순회한 결과를 'arr'에 담는 함수
 
+void rbtree_insert_fixup(rbtree *, node_t *); // 직접 연결한 적색 노드부터 불균형을 복구하는 함수 (strtree 등 다른 key 변형에서 사용)
+
+#ifdef RBTREE_AUGMENT
+void rbtree_augment_propagate(rbtree *, node_t *); // 노드부터 루트까지 집계값을 다시 계산하는 함수 (노드를 직접 연결하는 변형에서 사용)
+#else
+#define rbtree_augment_propagate(t, x) ((void)0)
+#endif
+
+#ifdef RBTREE_AUGMENT
+aug_t rbtree_range_aggregate(const rbtree *, const key_t, const key_t); // key가 [lo, hi)인 노드들의 집계값을 O(log n)에 반환하는 함수
+#endif
+
 #endif // _RBTREE_H_
@@ -0,0 +1,161 @@
+#include "strtree.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_CHUNK_SIZE (64 * 1024)
+
+// key를 이어 붙여 저장하는 chunk, 다 차면 새 chunk를 앞에 연결
+struct str_arena_t {
+    struct str_arena_t *next;
+    size_t used, size;
+    char data[];
+};
+
+static char *arena_alloc(strtree *t, size_t len) {
+    str_arena_t *a = t->arena;
+
+    if (a == NULL || a->size - a->used < len) {
+        size_t size = len > ARENA_CHUNK_SIZE ? len : ARENA_CHUNK_SIZE;
+        a = (str_arena_t *)malloc(sizeof(str_arena_t) + size);
+        a->next = t->arena;
+        a->used = 0;
+        a->size = size;
+        t->arena = a;
+    }
+
+    char *p = a->data + a->used;
+    a->used += len;
+    return p;
+}
+
+// 앞 8바이트를 big-endian으로 모으면 정수 대소와 사전순이 일치함
+static uint64_t make_prefix(const char *key, size_t len) {
+    uint64_t prefix = 0;
+
+    for (size_t i = 0; i < STRTREE_PREFIX_LEN; i++)
+        prefix = (prefix << 8) | (i < len ? (unsigned char)key[i] : 0);
+    return prefix;
+}
+
+static int compare(uint64_t prefix, const char *key, size_t len, const str_node_t *x) {
+    if (prefix != x->prefix)
+        return prefix < x->prefix ? -1 : 1;
+
+    // prefix가 같을 때만 9번째 바이트부터 본문 비교
+    size_t m = len < x->len ? len : x->len;
+    if (m > STRTREE_PREFIX_LEN) {
+        int c = memcmp(key + STRTREE_PREFIX_LEN, x->key + STRTREE_PREFIX_LEN, m - STRTREE_PREFIX_LEN);
+        if (c != 0)
+            return c;
+    }
+    return len < x->len ? -1 : len > x->len;
+}
+
+strtree *new_strtree(int copyKeys) {
+    strtree *t = (strtree *)calloc(1, sizeof(strtree));
+
+    t->tree = new_rbtree();
+    t->copyKeys = copyKeys;
+    return t;
+}
+
+void delete_strtree(strtree *t) {
+    // str_node_t는 node_t로 시작하므로 delete_rbtree의 free로 통째로 반환됨
+    delete_rbtree(t->tree);
+
+    while (t->arena != NULL) {
+        str_arena_t *next = t->arena->next;
+        free(t->arena);
+        t->arena = next;
+    }
+    free(t);
+}
+
+str_node_t *strtree_insert(strtree *t, const char *key, size_t len) {
+    rbtree *tree = t->tree;
+    node_t *y = tree->nil;
+    node_t *x = tree->root;
+    str_node_t *z = (str_node_t *)calloc(1, sizeof(str_node_t));
+    int isLeftmost = 1;
+    int isRightmost = 1;
+    int c = 0;
+
+    z->prefix = make_prefix(key, len);
+    z->len = len;
+    if (t->copyKeys) {
+        char *copy = arena_alloc(t, len);
+        memcpy(copy, key, len);
+        z->key = copy;
+    } else
+        z->key = key;
+
+    while (x != tree->nil) {
+        y = x;
+        c = compare(z->prefix, key, len, (str_node_t *)x);
+        if (c < 0) {
+            x = x->left;
+            isRightmost = 0;
+        } else {
+            x = x->right;
+            isLeftmost = 0;
+        }
+    }
+
+    z->node.parent = y;
+
+    if (isLeftmost)
+        tree->leftmost = &z->node;
+    if (isRightmost)
+        tree->rightmost = &z->node;
+
+    if (y == tree->nil)
+        tree->root = &z->node;
+    else if (c < 0)
+        y->left = &z->node;
+    else
+        y->right = &z->node;
+
+    z->node.left = tree->nil;
+    z->node.right = tree->nil;
+    z->node.color = RBTREE_RED;
+
+    // rbtree_insert와 마찬가지로 새 노드부터 루트까지의 집계값을 갱신 (RBTREE_AUGMENT가 없으면 비용 없음)
+    rbtree_augment_propagate(tree, &z->node);
+
+    rbtree_insert_fixup(tree, &z->node);
+
+    return z;
+}
+
+str_node_t *strtree_find(const strtree *t, const char *key, size_t len) {
+    const rbtree *tree = t->tree;
+    node_t *current = tree->root;
+    uint64_t prefix = make_prefix(key, len);
+
+    while (current != tree->nil) {
+        int c = compare(prefix, key, len, (str_node_t *)current);
+
+        if (c == 0)
+            return (str_node_t *)current;
+
+        if (c > 0)
+            current = current->right;
+        else
+            current = current->left;
+    }
+
+    return NULL;
+}
+
+str_node_t *strtree_min(const strtree *t) {
+    return (str_node_t *)rbtree_min(t->tree);
+}
+
+str_node_t *strtree_max(const strtree *t) {
+    return (str_node_t *)rbtree_max(t->tree);
+}
+
+int strtree_erase(strtree *t, str_node_t *z) {
+    return rbtree_erase(t->tree, &z->node);
+}
@@ -0,0 +1,40 @@
+#ifndef _STRTREE_H_
+#define _STRTREE_H_
+
+#include "rbtree.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 문자열(바이트열) key를 쓰는 RB tree 변형
+// key의 앞 8바이트를 big-endian 정수(prefix)로 노드에 함께 저장해서
+// 대부분의 비교를 정수 비교 한 번으로 끝내고, prefix가 같을 때만 key 본문을 읽음
+#define STRTREE_PREFIX_LEN 8
+
+typedef struct
+{
+  node_t node;     // 반드시 첫 멤버 (rbtree의 회전/삭제 코드를 그대로 사용)
+  uint64_t prefix; // key 앞 8바이트, 짧으면 0으로 채움
+  size_t len;
+  const char *key;
+} str_node_t;
+
+typedef struct str_arena_t str_arena_t;
+
+typedef struct
+{
+  rbtree *tree;
+  int copyKeys;       // 1이면 key를 arena에 복사해서 트리가 소유, 0이면 호출한 쪽 포인터를 그대로 보관
+  str_arena_t *arena; // 복사한 key를 담는 chunk 목록 (delete_strtree에서 한 번에 반환)
+} strtree;
+
+strtree *new_strtree(int copyKeys); // 새 문자열 트리를 생성하는 함수
+void delete_strtree(strtree *);     // 노드와 arena의 메모리를 모두 반환하는 함수
+
+str_node_t *strtree_insert(strtree *, const char *, size_t);     // key를 삽입하고 불균형을 복구하는 함수
+str_node_t *strtree_find(const strtree *, const char *, size_t); // key에 해당하는 노드를 반환하는 함수
+str_node_t *strtree_min(const strtree *);                        // 사전순 최소 노드를 반환하는 함수
+str_node_t *strtree_max(const strtree *);                        // 사전순 최대 노드를 반환하는 함수
+int strtree_erase(strtree *, str_node_t *);                      // 노드를 삭제하는 함수 (arena의 key 공간은 delete_strtree까지 유지)
+
+#endif // _STRTREE_H_
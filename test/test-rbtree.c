@@ -1,8 +1,11 @@
 #include <assert.h>
+#include <pthread.h>
 #include <rbtree.h>
+#include <strtree.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 // new_rbtree should return rbtree struct with null root node
 void test_init(void) {
@@ -367,6 +370,314 @@ void test_find_erase_rand(const size_t n, const unsigned int seed) {
   delete_rbtree(t);
 }
 
+// pop_min/pop_max should return keys in sorted order and keep min/max cached
+void test_pop_minmax(const size_t n, const unsigned int seed) {
+  srand(seed);
+  rbtree *t = new_rbtree();
+  key_t *arr = calloc(n, sizeof(key_t));
+  for (int i = 0; i < n; i++) {
+    arr[i] = rand() % (n / 2);
+    rbtree_insert(t, arr[i]);
+  }
+  qsort((void *)arr, n, sizeof(key_t), comp);
+
+  size_t lo = 0, hi = n;
+  key_t key;
+  while (lo < hi) {
+    assert(rbtree_min(t)->key == arr[lo]);
+    assert(rbtree_max(t)->key == arr[hi - 1]);
+    if ((lo + hi) % 3 == 0) {
+      assert(rbtree_pop_max(t, &key) == 0);
+      assert(key == arr[--hi]);
+    } else {
+      assert(rbtree_pop_min(t, &key) == 0);
+      assert(key == arr[lo++]);
+    }
+  }
+  assert(rbtree_min(t) == NULL);
+  assert(rbtree_max(t) == NULL);
+  assert(rbtree_pop_min(t, &key) == -1);
+  assert(rbtree_pop_max(t, &key) == -1);
+
+  free(arr);
+  delete_rbtree(t);
+}
+
+static size_t count_nodes(const node_t *p, const node_t *nil) {
+  if (p == nil) {
+    return 0;
+  }
+  return 1 + count_nodes(p->left, nil) + count_nodes(p->right, nil);
+}
+
+// detach should empty the tree in O(1) and destroy_step should free the old
+// nodes a bounded number at a time
+void test_detach_destroy(const size_t n, const size_t budget) {
+  rbtree *t = new_rbtree();
+  for (int i = 0; i < n; i++) {
+    rbtree_insert(t, i);
+  }
+
+  rbtree *old = rbtree_detach(t);
+  assert(old != NULL);
+  assert(old->nil != t->nil);
+  assert(t->root == t->nil);
+  assert(rbtree_min(t) == NULL);
+  assert(rbtree_find(t, 0) == NULL);
+  test_color_constraint(old);
+
+  // each step frees exactly budget nodes until the last one, and the emptied
+  // tree stays usable while the old one is torn down
+  size_t remaining = count_nodes(old->root, old->nil);
+  assert(remaining == n);
+  while (remaining > budget) {
+    assert(rbtree_destroy_step(old, budget) == 1);
+    size_t after = count_nodes(old->root, old->nil);
+    assert(remaining - after == budget);
+    remaining = after;
+    rbtree_insert(t, (key_t)remaining);
+  }
+  assert(rbtree_destroy_step(old, budget) == 0);
+  assert(rbtree_find(t, (key_t)remaining) != NULL);
+  delete_rbtree(t);
+}
+
+// trees handed to the reclaimer should all be freed by the time join returns
+void test_destroy_async(const size_t trees, const size_t n) {
+  for (size_t i = 0; i < trees; i++) {
+    rbtree *t = new_rbtree();
+    for (int j = 0; j < n; j++) {
+      rbtree_insert(t, j);
+    }
+    assert(rbtree_destroy_async(rbtree_detach(t)) == 0);
+    delete_rbtree(t);
+  }
+  assert(rbtree_reclaim_join() == trees);
+  assert(rbtree_reclaim_join() == 0);
+}
+
+static void *destroy_async_worker(void *arg) {
+  size_t *reclaimed = (size_t *)arg;
+  for (int round = 0; round < 4; round++) {
+    for (int i = 0; i < 4; i++) {
+      rbtree *t = new_rbtree();
+      for (int j = 0; j < 1000; j++) {
+        rbtree_insert(t, j);
+      }
+      rbtree_destroy_async(t);
+    }
+    *reclaimed += rbtree_reclaim_join();
+  }
+  return NULL;
+}
+
+// concurrent destroy_async/join calls should free every tree exactly once
+void test_destroy_async_concurrent(void) {
+  pthread_t tids[4];
+  size_t reclaimed[4] = {0};
+  for (int i = 0; i < 4; i++) {
+    assert(pthread_create(&tids[i], NULL, destroy_async_worker, &reclaimed[i]) == 0);
+  }
+  size_t total = 0;
+  for (int i = 0; i < 4; i++) {
+    pthread_join(tids[i], NULL);
+    total += reclaimed[i];
+  }
+  total += rbtree_reclaim_join();
+  assert(total == 4 * 4 * 4);
+}
+
+#ifdef RBTREE_AUGMENT
+// Every node's aggregate should equal the aggregate of its subtree
+static aug_t augment_traverse(const node_t *p, const node_t *nil, bool *ok) {
+  if (p == nil) {
+    return RBTREE_AUG_IDENTITY;
+  }
+  aug_t l = augment_traverse(p->left, nil, ok);
+  aug_t r = augment_traverse(p->right, nil, ok);
+  aug_t agg = RBTREE_AUG_COMBINE(RBTREE_AUG_COMBINE(l, RBTREE_AUG_VALUE(p)), r);
+  if (agg != p->aug) {
+    *ok = false;
+  }
+  return agg;
+}
+
+static void test_augment_constraint(const rbtree *t) {
+  bool ok = true;
+  augment_traverse(t->root, t->nil, &ok);
+  assert(ok);
+}
+#endif
+
+typedef struct {
+  char buf[24];
+  size_t len;
+} str_key_t;
+
+static int str_comp(const void *p1, const void *p2) {
+  const str_key_t *e1 = (const str_key_t *)p1;
+  const str_key_t *e2 = (const str_key_t *)p2;
+  size_t m = e1->len < e2->len ? e1->len : e2->len;
+  int c = memcmp(e1->buf, e2->buf, m);
+  if (c != 0) {
+    return c;
+  }
+  return e1->len < e2->len ? -1 : e1->len > e2->len;
+}
+
+// strtree should order byte-string keys lexicographically, including keys
+// that share the 8-byte prefix or contain zero bytes
+void test_strtree(const size_t n, const int copy_keys, const unsigned int seed) {
+  srand(seed);
+  strtree *t = new_strtree(copy_keys);
+  str_key_t *arr = calloc(n, sizeof(str_key_t));
+  for (int i = 0; i < n; i++) {
+    arr[i].len = rand() % sizeof(arr[i].buf);
+    memcpy(arr[i].buf, "commonprefix", arr[i].len < 12 ? arr[i].len : 12);
+    for (size_t j = rand() % (arr[i].len + 1); j < arr[i].len; j++) {
+      arr[i].buf[j] = rand() % 3;
+    }
+    str_node_t *p = strtree_insert(t, arr[i].buf, arr[i].len);
+    assert(p != NULL);
+    assert(p->len == arr[i].len);
+    assert(copy_keys ? p->key != arr[i].buf : p->key == arr[i].buf);
+  }
+  test_color_constraint(t->tree);
+#ifdef RBTREE_AUGMENT
+  test_augment_constraint(t->tree);
+#endif
+
+  for (int i = 0; i < n; i++) {
+    str_node_t *p = strtree_find(t, arr[i].buf, arr[i].len);
+    assert(p != NULL);
+    assert(p->len == arr[i].len && memcmp(p->key, arr[i].buf, p->len) == 0);
+  }
+  assert(strtree_find(t, "missing", 7) == NULL);
+
+  str_key_t *sorted = calloc(n, sizeof(str_key_t));
+  memcpy(sorted, arr, n * sizeof(str_key_t));
+  qsort((void *)sorted, n, sizeof(str_key_t), str_comp);
+  str_node_t *q = strtree_max(t);
+  assert(q->len == sorted[n - 1].len && memcmp(q->key, sorted[n - 1].buf, q->len) == 0);
+  for (int i = 0; i < n; i++) {
+    str_node_t *p = strtree_min(t);
+    assert(p != NULL);
+    assert(p->len == sorted[i].len && memcmp(p->key, sorted[i].buf, p->len) == 0);
+    strtree_erase(t, p);
+  }
+  assert(strtree_min(t) == NULL);
+
+  free(sorted);
+  free(arr);
+  delete_strtree(t);
+}
+
+#ifdef RBTREE_AUGMENT
+static aug_t range_aggregate_naive(const key_t *arr, const size_t n,
+                                   const key_t lo, const key_t hi) {
+  aug_t res = RBTREE_AUG_IDENTITY;
+  for (size_t i = 0; i < n; i++) {
+    if (arr[i] >= lo && arr[i] < hi) {
+      res = RBTREE_AUG_COMBINE(res, (aug_t)arr[i]);
+    }
+  }
+  return res;
+}
+
+// range aggregate should match a linear scan while nodes are inserted/erased
+void test_range_aggregate(const size_t n, const unsigned int seed) {
+  srand(seed);
+  rbtree *t = new_rbtree();
+  key_t *arr = calloc(n, sizeof(key_t));
+  for (int i = 0; i < n; i++) {
+    arr[i] = rand() % 1000;
+    rbtree_insert(t, arr[i]);
+  }
+  test_augment_constraint(t);
+  assert(rbtree_range_aggregate(t, 0, 1000) == range_aggregate_naive(arr, n, 0, 1000));
+  assert(rbtree_range_aggregate(t, 500, 500) == RBTREE_AUG_IDENTITY);
+
+  for (int i = 0; i < n; i++) {
+    key_t lo = rand() % 1000;
+    key_t hi = lo + rand() % 200;
+    assert(rbtree_range_aggregate(t, lo, hi) == range_aggregate_naive(arr + i, n - i, lo, hi));
+
+    rbtree_erase(t, rbtree_find(t, arr[i]));
+    if (i % 64 == 0) {
+      test_augment_constraint(t);
+    }
+  }
+  assert(rbtree_range_aggregate(t, 0, 1000) == RBTREE_AUG_IDENTITY);
+
+  free(arr);
+  delete_rbtree(t);
+}
+#endif
+
+// clone should copy shape and colors onto its own sentinel and stay
+// independent of the original
+void test_clone(const size_t n, const unsigned int seed) {
+  srand(seed);
+  rbtree *t = new_rbtree();
+  key_t *arr = calloc(n, sizeof(key_t));
+  for (int i = 0; i < n; i++) {
+    arr[i] = rand() % 1000;
+    rbtree_insert(t, arr[i]);
+  }
+
+  rbtree *c = rbtree_clone(t);
+  assert(c != NULL);
+  assert(c->nil != t->nil);
+  assert(c->root != t->root);
+  assert(c->root->key == t->root->key);
+  assert(c->root->color == t->root->color);
+  test_color_constraint(c);
+  test_search_constraint(c);
+#ifdef RBTREE_AUGMENT
+  test_augment_constraint(c);
+#endif
+  assert(rbtree_min(c)->key == rbtree_min(t)->key);
+  assert(rbtree_max(c)->key == rbtree_max(t)->key);
+
+  key_t *res = calloc(n, sizeof(key_t));
+  rbtree_to_array(c, res, n);
+  qsort((void *)arr, n, sizeof(key_t), comp);
+  for (int i = 0; i < n; i++) {
+    assert(arr[i] == res[i]);
+  }
+
+  // changes to one tree must not show up in the other, and nodes inserted
+  // after an erase should reuse the freed slot in the clone's pool
+  for (int i = 0; i < n / 2; i++) {
+    rbtree_erase(c, rbtree_find(c, arr[i]));
+    node_t *p = rbtree_insert(c, arr[i] + 1000);
+    assert(p >= c->pool && p < c->pool + c->poolSize);
+  }
+  test_color_constraint(c);
+  assert(rbtree_find(t, arr[n - 1] + 1000) == NULL);
+  assert(rbtree_min(t)->key == arr[0]);
+  test_color_constraint(t);
+
+  rbtree *e = rbtree_clone(c);
+  delete_rbtree(c);
+  rbtree_to_array(e, res, n);
+  for (int i = 0; i < n; i++) {
+    assert(res[i] == (i < n - n / 2 ? arr[n / 2 + i] : arr[i - (n - n / 2)] + 1000));
+  }
+
+  free(res);
+  free(arr);
+  delete_rbtree(e);
+  delete_rbtree(t);
+
+  rbtree *empty = new_rbtree();
+  c = rbtree_clone(empty);
+  assert(c->root == c->nil);
+  assert(rbtree_min(c) == NULL);
+  delete_rbtree(c);
+  delete_rbtree(empty);
+}
+
 int main(void) {
   test_init();
   test_insert_single(1024);
@@ -379,5 +690,15 @@ int main(void) {
   test_duplicate_values();
   test_multi_instance();
   test_find_erase_rand(10000, 17);
+  test_pop_minmax(1000, 23);
+  test_detach_destroy(10000, 64);
+  test_destroy_async(8, 10000);
+  test_destroy_async_concurrent();
+  test_clone(1000, 41);
+  test_strtree(2000, 1, 31);
+  test_strtree(2000, 0, 37);
+#ifdef RBTREE_AUGMENT
+  test_range_aggregate(2000, 29);
+#endif
   printf("Passed all tests!\n");
 }